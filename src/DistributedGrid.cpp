@@ -0,0 +1,440 @@
+#include "DistributedGrid.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <new>
+#include <sched.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#endif
+
+static_assert(ATOMIC_INT_LOCK_FREE == 2, "shared memory atomics must be lock-free to work across processes");
+
+namespace {
+
+const std::size_t CACHE_LINE = 64;
+
+// How long the coordinator sleeps before checking that no worker has died
+const int WORKER_CHECK_MS = 100;
+
+// Each block sits on its own cache line so workers do not false-share
+struct alignas(CACHE_LINE) ControlBlock {
+    std::atomic<int> targetGeneration;
+    std::atomic<int> quit;
+    std::atomic<int> wakeups;      // Bumped on every new target and on quit; idle workers sleep on it
+    std::atomic<int> finished;     // Bumped by each worker that reaches the target; the coordinator sleeps on it
+};
+
+struct alignas(CACHE_LINE) WorkerStatus {
+    std::atomic<int> generation;   // Last generation whose slab and population are published
+    std::atomic<int> population;
+    std::atomic<int> emptySince;   // First generation of the slab's current empty run, -1 if alive
+};
+
+struct alignas(CACHE_LINE) HaloSlot {
+    std::atomic<int> generation;   // Generation of the row stored after this header, -1 if none
+};
+
+// Sleep until `word` no longer holds `seen`, or for at most `timeoutMs` if it
+// is not negative. Returns false if the wait timed out. The futex is not
+// private, so it works across the processes sharing the mapping. Elsewhere,
+// fall back to yielding.
+bool waitForChange(std::atomic<int>* word, int seen, int timeoutMs = -1) {
+#ifdef __linux__
+    struct timespec timeout = { timeoutMs / 1000, (long)(timeoutMs % 1000) * 1000000 };
+    if (syscall(SYS_futex, (int*)word, FUTEX_WAIT, seen, timeoutMs < 0 ? nullptr : &timeout, nullptr, 0) < 0) {
+        return errno != ETIMEDOUT;
+    }
+    return true;
+#else
+    (void)word;
+    (void)seen;
+    (void)timeoutMs;
+    sched_yield();
+    return true;
+#endif
+}
+
+void wakeAll(std::atomic<int>* word) {
+    word->fetch_add(1, std::memory_order_release);
+#ifdef __linux__
+    syscall(SYS_futex, (int*)word, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#endif
+}
+
+std::size_t roundUp(std::size_t size, std::size_t alignment) {
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+// Rings for the boundary between worker b and b + 1
+int downRing(int boundary) { return boundary * 2; }     // b's last row to b + 1's top halo
+int upRing(int boundary) { return boundary * 2 + 1; }   // b + 1's first row to b's bottom halo
+
+// Rows are padded with a dead column on each side, matching Grid's dead border.
+// Returns how many cells of the new row are alive.
+int stepRow(const uint8_t* above, const uint8_t* row, const uint8_t* below, uint8_t* out, int width) {
+    int alive = 0;
+    for (int x = 1; x <= width; x++) {
+        int neighbors = above[x - 1] + above[x] + above[x + 1] +
+                        row[x - 1] + row[x + 1] +
+                        below[x - 1] + below[x] + below[x + 1];
+        out[x] = row[x] ? (neighbors == 2 || neighbors == 3) : (neighbors == 3);
+        alive += out[x];
+    }
+    return alive;
+}
+
+} // namespace
+
+DistributedGrid::DistributedGrid(int width, int height, int workerCount)
+    : width(width), height(height), workerCount(workerCount), generation(0), population(0),
+      extinctGeneration(-1),
+      shared(nullptr), sharedSize(0), rowStride(0) {
+    if (this->workerCount > height) {
+        this->workerCount = height;
+    }
+    if (this->workerCount < 1) {
+        this->workerCount = 1;
+    }
+    rowStride = sizeof(HaloSlot) + roundUp(width, CACHE_LINE);
+}
+
+DistributedGrid::~DistributedGrid() {
+    stop();
+}
+
+std::size_t DistributedGrid::statusOffset(int worker) const {
+    return sizeof(ControlBlock) + worker * sizeof(WorkerStatus);
+}
+
+std::size_t DistributedGrid::slotOffset(int ring, int slot) const {
+    return statusOffset(workerCount) + (ring * HALO_RING_SLOTS + slot) * rowStride;
+}
+
+std::size_t DistributedGrid::boardOffset() const {
+    return slotOffset(2 * (workerCount - 1), 0);
+}
+
+bool DistributedGrid::start(const Grid& initial) {
+    if (shared) {
+        return false;
+    }
+
+    sharedSize = boardOffset() + (std::size_t)width * height;
+
+    char name[64];
+    snprintf(name, sizeof(name), "/bitbloom-%d", (int)getpid());
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        perror("shm_open");
+        return false;
+    }
+
+    void* mapping = MAP_FAILED;
+    if (ftruncate(fd, sharedSize) == 0) {
+        mapping = mmap(nullptr, sharedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    // The mapping outlives the name, which is removed so nothing leaks if we crash
+    shm_unlink(name);
+    if (mapping == MAP_FAILED) {
+        perror("mmap");
+        return false;
+    }
+    shared = (uint8_t*)mapping;
+
+    ControlBlock* control = new (shared) ControlBlock();
+    control->targetGeneration.store(0);
+    control->quit.store(0);
+    control->wakeups.store(0);
+    control->finished.store(0);
+
+    for (int i = 0; i < workerCount; i++) {
+        WorkerStatus* status = new (shared + statusOffset(i)) WorkerStatus();
+        status->generation.store(0);
+        status->population.store(0);
+        status->emptySince.store(-1);
+    }
+
+    for (int ring = 0; ring < 2 * (workerCount - 1); ring++) {
+        for (int slot = 0; slot < HALO_RING_SLOTS; slot++) {
+            HaloSlot* header = new (shared + slotOffset(ring, slot)) HaloSlot();
+            header->generation.store(-1);
+        }
+    }
+
+    uint8_t* board = shared + boardOffset();
+    population = 0;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            board[y * width + x] = initial.getCell(x, y);
+            population += board[y * width + x];
+        }
+    }
+    generation = 0;
+    extinctGeneration = population == 0 ? 0 : -1;
+
+    for (int i = 0; i < workerCount; i++) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            perror("fork");
+            stop();
+            return false;
+        }
+        if (pid == 0) {
+#ifdef __linux__
+            // Don't outlive a coordinator that crashed
+            prctl(PR_SET_PDEATHSIG, SIGTERM);
+#endif
+            runWorker(i);
+            _exit(0);
+        }
+        workers.push_back(pid);
+    }
+
+    return true;
+}
+
+bool DistributedGrid::step(int generations) {
+    if (!shared || generations <= 0) {
+        return shared != nullptr;
+    }
+
+    ControlBlock* control = (ControlBlock*)shared;
+    int target = generation + generations;
+    control->targetGeneration.store(target, std::memory_order_release);
+    wakeAll(&control->wakeups);
+
+    // Sleep until every worker has published the target. Reading the finished
+    // count before the statuses means a worker finishing in between makes the
+    // wait return at once instead of being missed.
+    int polls = 0;
+    while (true) {
+        int seen = control->finished.load(std::memory_order_acquire);
+        int done = 0;
+        for (int i = 0; i < workerCount; i++) {
+            WorkerStatus* status = (WorkerStatus*)(shared + statusOffset(i));
+            if (status->generation.load(std::memory_order_acquire) == target) {
+                done++;
+            }
+        }
+        if (done == workerCount) {
+            break;
+        }
+
+        bool woken = waitForChange(&control->finished, seen, WORKER_CHECK_MS);
+        if ((!woken || ++polls % 4096 == 0) && !workersAlive()) {
+            return false;
+        }
+    }
+
+    generation = target;
+    population = 0;
+    int emptySince = 0;
+    for (int i = 0; i < workerCount; i++) {
+        WorkerStatus* status = (WorkerStatus*)(shared + statusOffset(i));
+        population += status->population.load(std::memory_order_relaxed);
+        emptySince = std::max(emptySince, status->emptySince.load(std::memory_order_relaxed));
+    }
+    // Slabs only stay empty while the whole board is, so the board died out
+    // when the last slab did
+    if (population == 0 && extinctGeneration < 0) {
+        extinctGeneration = emptySince;
+    }
+    return true;
+}
+
+bool DistributedGrid::runUntilExtinct(int maxGenerations, int checkInterval) {
+    while (population > 0 && generation < maxGenerations) {
+        int generations = checkInterval;
+        if (generations > maxGenerations - generation) {
+            generations = maxGenerations - generation;
+        }
+        if (!step(generations)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void DistributedGrid::stop() {
+    if (!shared) {
+        return;
+    }
+
+    ControlBlock* control = (ControlBlock*)shared;
+    control->quit.store(1, std::memory_order_release);
+    wakeAll(&control->wakeups);
+    for (pid_t pid : workers) {
+        while (waitpid(pid, nullptr, 0) < 0 && errno == EINTR) {
+        }
+    }
+    workers.clear();
+
+    munmap(shared, sharedSize);
+    shared = nullptr;
+}
+
+void DistributedGrid::copyTo(Grid& grid) const {
+    if (!shared) {
+        return;
+    }
+
+    const uint8_t* board = shared + boardOffset();
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            grid.setCell(x, y, board[y * width + x] != 0);
+        }
+    }
+}
+
+bool DistributedGrid::workersAlive() {
+    for (pid_t pid : workers) {
+        if (waitpid(pid, nullptr, WNOHANG) != 0) {
+            fprintf(stderr, "Worker process %d exited unexpectedly\n", (int)pid);
+            return false;
+        }
+    }
+    return true;
+}
+
+void DistributedGrid::runWorker(int index) {
+    ControlBlock* control = (ControlBlock*)shared;
+    WorkerStatus* status = (WorkerStatus*)(shared + statusOffset(index));
+    uint8_t* board = shared + boardOffset();
+
+    int firstRow = slabStart(index);
+    int rows = slabStart(index + 1) - firstRow;
+    bool hasAbove = index > 0;
+    bool hasBelow = index < workerCount - 1;
+
+    // Slab rows 1..rows, with halo rows 0 and rows + 1 that stay dead at the board edge
+    std::size_t stride = width + 2;
+    std::vector<uint8_t> current((rows + 2) * stride, 0);
+    std::vector<uint8_t> next((rows + 2) * stride, 0);
+    for (int r = 0; r < rows; r++) {
+        memcpy(&current[(r + 1) * stride + 1], board + (std::size_t)(firstRow + r) * width, width);
+    }
+
+    auto publish = [&](int ring, int gen, const uint8_t* row) {
+        uint8_t* slot = shared + slotOffset(ring, gen % HALO_RING_SLOTS);
+        memcpy(slot + sizeof(HaloSlot), row + 1, width);
+        ((HaloSlot*)slot)->generation.store(gen, std::memory_order_release);
+    };
+
+    auto tryReceive = [&](int ring, int gen, uint8_t* row) {
+        uint8_t* slot = shared + slotOffset(ring, gen % HALO_RING_SLOTS);
+        if (((HaloSlot*)slot)->generation.load(std::memory_order_acquire) != gen) {
+            return false;
+        }
+        memcpy(row + 1, slot + sizeof(HaloSlot), width);
+        return true;
+    };
+
+    int gen = 0;
+    int emptySince = -1;
+    if (std::count(current.begin(), current.end(), 1) == 0) {
+        emptySince = 0;
+    }
+    while (true) {
+        // Sleep between steps. Reading the wakeup count before the target means a
+        // step started in between makes the wait return at once instead of being missed.
+        int target;
+        while (true) {
+            int seen = control->wakeups.load(std::memory_order_acquire);
+            if (control->quit.load(std::memory_order_acquire)) {
+                return;
+            }
+            target = control->targetGeneration.load(std::memory_order_acquire);
+            if (target != gen) {
+                break;
+            }
+            waitForChange(&control->wakeups, seen);
+        }
+
+        uint8_t* cur = current.data();
+        uint8_t* out = next.data();
+
+        // Send our edge rows first so neighbours can start on theirs
+        if (hasAbove) {
+            publish(upRing(index - 1), gen, cur + stride);
+        }
+        if (hasBelow) {
+            publish(downRing(index), gen, cur + rows * stride);
+        }
+
+        // Interior rows only depend on our own cells
+        int alive = 0;
+        for (int r = 2; r < rows; r++) {
+            alive += stepRow(cur + (r - 1) * stride, cur + r * stride, cur + (r + 1) * stride, out + r * stride, width);
+        }
+
+        // Finish each edge row as soon as its halo has arrived
+        bool haveTop = !hasAbove;
+        bool haveBottom = !hasBelow;
+        bool topDone = false;
+        bool bottomDone = false;
+        while (!topDone || !bottomDone) {
+            if (!haveTop) {
+                haveTop = tryReceive(downRing(index - 1), gen, cur);
+            }
+            if (!haveBottom) {
+                haveBottom = tryReceive(upRing(index), gen, cur + (rows + 1) * stride);
+            }
+
+            if (rows == 1) {
+                if (haveTop && haveBottom) {
+                    alive += stepRow(cur, cur + stride, cur + 2 * stride, out + stride, width);
+                    topDone = bottomDone = true;
+                }
+            } else {
+                if (haveTop && !topDone) {
+                    alive += stepRow(cur, cur + stride, cur + 2 * stride, out + stride, width);
+                    topDone = true;
+                }
+                if (haveBottom && !bottomDone) {
+                    alive += stepRow(cur + (rows - 1) * stride, cur + rows * stride, cur + (rows + 1) * stride,
+                            out + rows * stride, width);
+                    bottomDone = true;
+                }
+            }
+
+            if (!topDone || !bottomDone) {
+                if (control->quit.load(std::memory_order_acquire)) {
+                    return;
+                }
+                sched_yield();
+            }
+        }
+
+        current.swap(next);
+        gen++;
+
+        if (alive > 0) {
+            emptySince = -1;
+        } else if (emptySince < 0) {
+            emptySince = gen;
+        }
+
+        if (gen == target) {
+            for (int r = 0; r < rows; r++) {
+                memcpy(board + (std::size_t)(firstRow + r) * width, &current[(r + 1) * stride + 1], width);
+            }
+            status->population.store(alive, std::memory_order_relaxed);
+            status->emptySince.store(emptySince, std::memory_order_relaxed);
+            status->generation.store(gen, std::memory_order_release);
+            wakeAll(&control->finished);
+        }
+    }
+}
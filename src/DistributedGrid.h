@@ -0,0 +1,79 @@
+#ifndef DISTRIBUTEDGRID_H
+#define DISTRIBUTEDGRID_H
+
+#include "Grid.h"
+#include <cstddef>
+#include <cstdint>
+#include <sys/types.h>
+#include <vector>
+
+// Runs the Game of Life across several local worker processes for boards too
+// large for one process's memory bandwidth. The board is split into
+// horizontal slabs, one per worker. Each generation, workers swap their edge
+// rows with their neighbours through ring buffers in POSIX shared memory,
+// computing interior rows while the halos are in flight. The owning process
+// acts as coordinator: it sets how far to run and gathers the population.
+// Workers sleep on a futex in the shared mapping between steps, and the
+// coordinator sleeps on another until they finish one.
+class DistributedGrid {
+public:
+    // Generations a worker may run ahead of a neighbour is bounded by the halo
+    // dependency to one, so a short ring is enough
+    static const int HALO_RING_SLOTS = 4;
+
+    DistributedGrid(int width, int height, int workerCount);
+    ~DistributedGrid();
+
+    // Copy the initial board into shared memory and fork the workers
+    bool start(const Grid& initial);
+
+    // Advance every slab by `generations` and wait for all workers to finish.
+    // Returns false if a worker died.
+    bool step(int generations);
+
+    // Step in chunks of `checkInterval` until the board is empty or
+    // `maxGenerations` is reached. Returns false if a worker died. The board
+    // may have died out partway through the last chunk; see getExtinctGeneration.
+    bool runUntilExtinct(int maxGenerations, int checkInterval = 16);
+
+    // Stop and reap the workers. Called by the destructor.
+    void stop();
+
+    int getGeneration() const { return generation; }
+    int getWorkerCount() const { return workerCount; }
+    int countAliveCells() const { return population; }
+
+    // First generation at which the board was empty, or -1 if it never was
+    int getExtinctGeneration() const { return extinctGeneration; }
+
+    // Gather the board as of the last completed step
+    void copyTo(Grid& grid) const;
+
+private:
+    int width;
+    int height;
+    int workerCount;
+    int generation;
+    int population;
+    int extinctGeneration;
+
+    uint8_t* shared;
+    std::size_t sharedSize;
+    std::size_t rowStride;   // Halo slot size: header plus one padded row
+    std::vector<pid_t> workers;
+
+    DistributedGrid(const DistributedGrid&) = delete;
+    DistributedGrid& operator=(const DistributedGrid&) = delete;
+
+    // Shared memory layout
+    std::size_t statusOffset(int worker) const;
+    std::size_t slotOffset(int ring, int slot) const;
+    std::size_t boardOffset() const;
+
+    int slabStart(int worker) const { return (int)((long)worker * height / workerCount); }
+
+    bool workersAlive();
+    void runWorker(int index);
+};
+
+#endif // DISTRIBUTEDGRID_H
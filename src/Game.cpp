@@ -3,36 +3,42 @@
 #include "raylib.h"
 #include <ctime>
 #include <cstdio>
+#include <sys/stat.h>
 
 Game::Game(int gridWidth, int gridHeight, int cellSize) 
     : gridWidth(gridWidth), gridHeight(gridHeight), cellSize(cellSize),
       gridOffsetX(GRID_PADDING_X), gridOffsetY(UI_TOP_HEIGHT),
-      currentState(MAIN_MENU), gameTimer(0.0f), finalTime(0.0f), frameCounter(0) {
+      currentState(MAIN_MENU), gameTimer(0.0f), finalTime(0.0f), frameCounter(0),
+      runFrame(0) {
     
     screenWidth = gridWidth * cellSize + (GRID_PADDING_X * 2);
     screenHeight = gridHeight * cellSize + UI_TOP_HEIGHT + UI_BOTTOM_HEIGHT;
     
     grid = new Grid(gridWidth, gridHeight);
+    history = new GridHistory(gridWidth, gridHeight);
+    preview = new LookaheadPreview(gridWidth, gridHeight);
     shapeDetector = new ShapeDetector();
     
     // Load shapes from directory
     shapeDetector->loadShapesFromDirectory("shapes");
     
-    // Set up callbacks for detected shapes
-    setupShapeCallbacks();
+    // Subscribe to detected shape events
+    setupShapeSubscriptions();
     
     SetRandomSeed(time(NULL));
 }
 
 Game::~Game() {
     delete grid;
+    delete history;
+    delete preview;
     delete shapeDetector;
 }
 
 void Game::run() {
     SetExitKey(0);
     InitWindow(screenWidth, screenHeight, "BitBloom");
-    SetTargetFPS(60);
+    SetTargetFPS(RunRecord::TARGET_FPS);
     
     while (!WindowShouldClose()) {
         handleInput();
@@ -63,19 +69,23 @@ void Game::update() {
         gameTimer += GetFrameTime();
         
         // Update simulation
+        runFrame++;
         frameCounter++;
-        if (frameCounter >= 6) {
+        if (frameCounter >= RunRecord::FRAMES_PER_GENERATION) {
             grid->update();
+            history->push(*grid);
             frameCounter = 0;
             
             // Detect shapes after grid update
-            shapeDetector->detectAndTrigger(*grid);
+            shapeDetector->detectAndDispatch(*grid);
         }
         
         // Check win condition
         if (grid->countAliveCells() == 0) {
             finalTime = gameTimer;
             currentState = WIN_SCREEN;
+            preview->cancel();
+            saveRun();
         }
     }
 }
@@ -100,10 +110,15 @@ void Game::render() {
 }
 
 void Game::startNewGame() {
+    unsigned int seed = (unsigned int)GetRandomValue(0, 1000000000);
     grid->clear();
-    grid->randomSeed(0.3f);
+    grid->randomSeed(seed, RunRecord::SEED_DENSITY);
+    runRecord.begin(gridWidth, gridHeight, seed, RunRecord::SEED_DENSITY);
+    history->clear();
+    history->push(*grid);
     currentState = GAME;
     frameCounter = 0;
+    runFrame = 0;
     gameTimer = 0.0f;
 }
 
@@ -126,16 +141,32 @@ void Game::handleMainMenuInput() {
 }
 
 void Game::handleGameInput() {
+    Vector2 mousePos = GetMousePosition();
+    int hoverX = (mousePos.x - gridOffsetX) / cellSize;
+    int hoverY = (mousePos.y - gridOffsetY) / cellSize;
+    bool hoverInGrid = mousePos.x >= gridOffsetX && mousePos.y >= gridOffsetY &&
+                       hoverX < gridWidth && hoverY < gridHeight;
+    
     // Allow player to add cells by clicking
     if (IsMouseButtonDown(MOUSE_LEFT_BUTTON)) {
-        Vector2 mousePos = GetMousePosition();
-        int x = (mousePos.x - gridOffsetX) / cellSize;
-        int y = (mousePos.y - gridOffsetY) / cellSize;
-        if (x >= 0 && x < gridWidth && y >= 0 && y < gridHeight) {
-            grid->setCell(x, y, true);
+        if (hoverInGrid && !grid->getCell(hoverX, hoverY)) {
+            grid->setCell(hoverX, hoverY, true);
+            runRecord.addSetCell(runFrame, hoverX, hoverY);
         }
     }
     
+    // Show what placing a cell under the cursor would do
+    if (hoverInGrid) {
+        preview->request(*grid, hoverX, hoverY);
+    } else {
+        preview->cancel();
+    }
+    
+    // Step back in time to retry a placement
+    if (IsKeyPressed(KEY_Z)) {
+        rewindHistory();
+    }
+    
     // Debug: Print all detected shapes when space is pressed
     if (IsKeyPressed(KEY_SPACE)) {
         printf("\n=== Shape Detection Debug ===\n");
@@ -163,11 +194,36 @@ void Game::handleGameInput() {
     
     if (IsKeyPressed(KEY_ESCAPE)) {
         currentState = MAIN_MENU;
+        preview->cancel();
         grid->clear();
         gameTimer = 0.0f;
     }
 }
 
+void Game::rewindHistory() {
+    int generationsBack = REWIND_GENERATIONS;
+    if (generationsBack > history->generationsBehind()) {
+        generationsBack = history->generationsBehind();
+    }
+    
+    if (history->rewind(generationsBack, *grid)) {
+        frameCounter = 0;
+        runRecord.addRewind(runFrame, generationsBack);
+    }
+}
+
+void Game::saveRun() {
+    runRecord.finish(runFrame, finalTime);
+    
+    // Runs are kept for leaderboard verification with bitbloom_verify
+    mkdir("runs", 0755);
+    char filename[64];
+    snprintf(filename, sizeof(filename), "runs/run_%ld_%u.txt", (long)time(NULL), runRecord.getSeed());
+    if (!runRecord.saveToFile(filename)) {
+        printf("Failed to save run to %s\n", filename);
+    }
+}
+
 void Game::handleWinScreenInput() {
     int buttonWidth = 300;
     int buttonHeight = 60;
@@ -205,42 +261,62 @@ void Game::renderGame() {
         }
     }
     
+    renderPreview();
+    
     // Draw border around game grid
     DrawRectangleLines(gridOffsetX, gridOffsetY, gridWidth * cellSize, gridHeight * cellSize, WHITE);
 }
 
+void Game::renderPreview() {
+    // Farthest generations first and faintest, so nearer ones draw on top
+    const std::vector<Grid>& frames = preview->getFrames();
+    for (int i = (int)frames.size() - 1; i >= 0; i--) {
+        float alpha = 0.5f * (1.0f - (float)i / preview->getGenerations());
+        for (int y = 0; y < gridHeight; y++) {
+            for (int x = 0; x < gridWidth; x++) {
+                if (frames[i].getCell(x, y) && !grid->getCell(x, y)) {
+                    DrawRectangle(x * cellSize + gridOffsetX, y * cellSize + gridOffsetY, 
+                                cellSize - 1, cellSize - 1, Fade(SKYBLUE, alpha));
+                }
+            }
+        }
+    }
+}
+
 void Game::renderWinScreen() {
     UI::drawWinScreen(finalTime, screenWidth, screenHeight);
     // Buttons are drawn in handleWinScreenInput
 }
 
-void Game::setupShapeCallbacks() {
-    // Set up callbacks for each loaded shape
-    for (Shape* shape : shapeDetector->getShapes()) {
-        std::string shapeName = shape->getName();
-        
-        // Example callbacks - customize these for each shape!
-        if (shapeName == "diamond") {
-            shape->setCallback([](int x, int y) {
-                // TODO: Add sound effect or visual feedback
-                (void)x; (void)y; // Unused for now
-                // PlaySound(diamondSound);
-            });
-        }
-        else if (shapeName == "glider") {
-            shape->setCallback([](int x, int y) {
-                // TODO: Add glider detection feedback
-                (void)x; (void)y;
-                // PlaySound(gliderSound);
-            });
-        }
-        else if (shapeName == "blinker") {
-            shape->setCallback([](int x, int y) {
-                // TODO: Add blinker detection feedback
-                (void)x; (void)y;
-                // PlaySound(blinkerSound);
-            });
-        }
-        // Add more shape-specific callbacks as needed
+void Game::setupShapeSubscriptions() {
+    // Shape IDs are looked up by name once here; detection only deals in IDs.
+    // Each handler gets all matches of its shape from one update together.
+    // Example handlers - customize these for each shape!
+    int diamondId = shapeDetector->findShapeId("diamond");
+    if (diamondId >= 0) {
+        shapeDetector->subscribe(diamondId, [](const ShapeEvent* events, std::size_t count) {
+            // TODO: Add sound effect or visual feedback
+            (void)events; (void)count; // Unused for now
+            // PlaySound(diamondSound);
+        });
+    }
+    
+    int gliderId = shapeDetector->findShapeId("glider");
+    if (gliderId >= 0) {
+        shapeDetector->subscribe(gliderId, [](const ShapeEvent* events, std::size_t count) {
+            // TODO: Add glider detection feedback
+            (void)events; (void)count;
+            // PlaySound(gliderSound);
+        });
+    }
+    
+    int blinkerId = shapeDetector->findShapeId("blinker");
+    if (blinkerId >= 0) {
+        shapeDetector->subscribe(blinkerId, [](const ShapeEvent* events, std::size_t count) {
+            // TODO: Add blinker detection feedback
+            (void)events; (void)count;
+            // PlaySound(blinkerSound);
+        });
     }
+    // Add more shape subscriptions as needed, or subscribeAll() for every event
 }
@@ -2,6 +2,9 @@
 #define GAME_H
 
 #include "Grid.h"
+#include "GridHistory.h"
+#include "LookaheadPreview.h"
+#include "RunRecord.h"
 #include "GameState.h"
 #include "ShapeDetector.h"
 
@@ -17,6 +20,7 @@ private:
     static const int UI_TOP_HEIGHT = 50;
     static const int UI_BOTTOM_HEIGHT = 40;
     static const int GRID_PADDING_X = 20;
+    static const int REWIND_GENERATIONS = 20;
     
     int gridWidth;
     int gridHeight;
@@ -27,27 +31,34 @@ private:
     int screenHeight;
     
     Grid* grid;
+    GridHistory* history;
+    LookaheadPreview* preview;
     ShapeDetector* shapeDetector;
     GameState currentState;
     
     float gameTimer;
     float finalTime;
     int frameCounter;
+    int runFrame;
+    RunRecord runRecord;
     
     void handleInput();
     void update();
     void render();
     
     void startNewGame();
+    void rewindHistory();
+    void saveRun();
     void handleMainMenuInput();
     void handleGameInput();
     void handleWinScreenInput();
     
     void renderMainMenu();
     void renderGame();
+    void renderPreview();
     void renderWinScreen();
     
-    void setupShapeCallbacks();
+    void setupShapeSubscriptions();
 };
 
 #endif // GAME_H
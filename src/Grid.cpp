@@ -1,13 +1,56 @@
 #include "Grid.h"
-#include "raylib.h"
+
+namespace {
+
+// Result of one 2x2 block for every 4x4 neighbourhood. The index holds the
+// neighbourhood column by column: bit (col * 4 + row). Each result is a nibble
+// with bits (1,1), (1,2), (2,1), (2,2) as (col, row), packed two per byte so
+// the whole table is 32KB and stays in L1/L2 while stepping.
+const uint8_t* lookupTable() {
+    static const std::vector<uint8_t> table = [] {
+        std::vector<uint8_t> packed(1 << 15, 0);
+        for (int index = 0; index < (1 << 16); index++) {
+            int result = 0;
+            for (int col = 1; col <= 2; col++) {
+                for (int row = 1; row <= 2; row++) {
+                    int neighbors = 0;
+                    for (int dc = -1; dc <= 1; dc++) {
+                        for (int dr = -1; dr <= 1; dr++) {
+                            if (dc == 0 && dr == 0) continue;
+                            neighbors += (index >> ((col + dc) * 4 + row + dr)) & 1;
+                        }
+                    }
+                    bool alive = (index >> (col * 4 + row)) & 1;
+                    if (alive ? (neighbors == 2 || neighbors == 3) : (neighbors == 3)) {
+                        result |= 1 << ((col - 1) * 2 + (row - 1));
+                    }
+                }
+            }
+            packed[index >> 1] |= result << ((index & 1) * 4);
+        }
+        return packed;
+    }();
+    return table.data();
+}
+
+} // namespace
 
 Grid::Grid(int width, int height) 
     : width(width), height(height),
       cells(height, std::vector<bool>(width, false)),
-      nextCells(height, std::vector<bool>(width, false)) {
+      nextCells(height, std::vector<bool>(width, false)),
+      engine(ENGINE_CELLWISE) {
 }
 
 void Grid::update() {
+    if (engine == ENGINE_LOOKUP) {
+        updateLookup();
+    } else {
+        updateCellwise();
+    }
+}
+
+void Grid::updateCellwise() {
     for (int y = 0; y < height; y++) {
         for (int x = 0; x < width; x++) {
             int neighbors = countNeighbors(x, y);
@@ -31,10 +74,16 @@ void Grid::clear() {
     }
 }
 
-void Grid::randomSeed(float density) {
+void Grid::randomSeed(unsigned int seed, float density) {
+    // xorshift32 rather than the platform rand() so every machine sees the same board
+    uint32_t state = seed ? seed : 0x9E3779B9u;
+    int threshold = (int)(density * 100);
     for (int y = 0; y < height; y++) {
         for (int x = 0; x < width; x++) {
-            cells[y][x] = (GetRandomValue(0, 100) < (int)(density * 100));
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            cells[y][x] = ((int)(state % 101) < threshold);
         }
     }
 }
@@ -62,6 +111,53 @@ int Grid::countAliveCells() const {
     return count;
 }
 
+void Grid::updateLookup() {
+    const uint8_t* table = lookupTable();
+    
+    // Cell (x, y) lives at (x + 1, y + 1), leaving dead cells around the board
+    // and enough padding right and below for the last block on odd sizes
+    int stride = width + 3;
+    lookupPlane.assign((std::size_t)stride * (height + 3), 0);
+    for (int y = 0; y < height; y++) {
+        uint8_t* row = &lookupPlane[(std::size_t)(y + 1) * stride + 1];
+        for (int x = 0; x < width; x++) {
+            row[x] = cells[y][x];
+        }
+    }
+    
+    for (int y = 0; y < height; y += 2) {
+        const uint8_t* r0 = &lookupPlane[(std::size_t)y * stride];
+        const uint8_t* r1 = r0 + stride;
+        const uint8_t* r2 = r1 + stride;
+        const uint8_t* r3 = r2 + stride;
+        
+        // Slide the 4x4 window right two columns per block, adding two new columns
+        int index = (r0[0] | r1[0] << 1 | r2[0] << 2 | r3[0] << 3) << 8 |
+                    (r0[1] | r1[1] << 1 | r2[1] << 2 | r3[1] << 3) << 12;
+        bool hasRow2 = (y + 1 < height);
+        
+        for (int x = 0; x < width; x += 2) {
+            index = (index >> 8) |
+                    (r0[x + 2] | r1[x + 2] << 1 | r2[x + 2] << 2 | r3[x + 2] << 3) << 8 |
+                    (r0[x + 3] | r1[x + 3] << 1 | r2[x + 3] << 2 | r3[x + 3] << 3) << 12;
+            int result = (table[index >> 1] >> ((index & 1) * 4)) & 0xF;
+            
+            nextCells[y][x] = result & 1;
+            if (hasRow2) nextCells[y + 1][x] = (result >> 1) & 1;
+            if (x + 1 < width) {
+                nextCells[y][x + 1] = (result >> 2) & 1;
+                if (hasRow2) nextCells[y + 1][x + 1] = (result >> 3) & 1;
+            }
+        }
+    }
+    
+    cells.swap(nextCells);
+}
+
+bool Grid::operator==(const Grid& other) const {
+    return width == other.width && height == other.height && cells == other.cells;
+}
+
 int Grid::countNeighbors(int x, int y) const {
     int count = 0;
     for (int dy = -1; dy <= 1; dy++) {
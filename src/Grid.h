@@ -1,15 +1,26 @@
 #ifndef GRID_H
 #define GRID_H
 
+#include <cstdint>
 #include <vector>
 
+// How Grid::update() computes the next generation. Both give identical results.
+enum GridEngine {
+    ENGINE_CELLWISE,    // Counts the neighbours of every cell
+    ENGINE_LOOKUP       // Steps 2x2 blocks through a table indexed by their 4x4 neighbourhood
+};
+
 class Grid {
 public:
     Grid(int width, int height);
     
     void update();
     void clear();
-    void randomSeed(float density = 0.3f);
+    
+    void setEngine(GridEngine engine) { this->engine = engine; }
+    GridEngine getEngine() const { return engine; }
+    // Deterministic for a given seed so recorded runs can be replayed
+    void randomSeed(unsigned int seed, float density = 0.3f);
     
     bool getCell(int x, int y) const;
     void setCell(int x, int y, bool alive);
@@ -18,13 +29,20 @@ public:
     int getHeight() const { return height; }
     int countAliveCells() const;
     
+    bool operator==(const Grid& other) const;
+    bool operator!=(const Grid& other) const { return !(*this == other); }
+    
 private:
     int width;
     int height;
     std::vector<std::vector<bool>> cells;
     std::vector<std::vector<bool>> nextCells;
+    GridEngine engine;
+    std::vector<uint8_t> lookupPlane;   // Scratch for ENGINE_LOOKUP: cells as bytes with a dead border
     
     int countNeighbors(int x, int y) const;
+    void updateCellwise();
+    void updateLookup();
 };
 
 #endif // GRID_H
@@ -0,0 +1,228 @@
+#include "GridHistory.h"
+#include <algorithm>
+
+// Bookkeeping malloc keeps next to every block, charged so the budget holds in practice
+static const std::size_t ALLOCATION_OVERHEAD = 16;
+
+static std::size_t heapBytes(std::size_t capacityBytes) {
+    return capacityBytes > 0 ? capacityBytes + ALLOCATION_OVERHEAD : 0;
+}
+
+GridHistory::GridHistory(int width, int height, std::size_t memoryBudgetBytes)
+    : width(width), height(height),
+      tilesX((width + TILE_WIDTH - 1) / TILE_WIDTH),
+      tilesY((height + TILE_HEIGHT - 1) / TILE_HEIGHT),
+      memoryBudget(0), generationBytes(0), maxGenerations(1), head(0), count(0), cursor(0) {
+    cursorTiles.resize(tilesX * tilesY);
+    nextTiles.resize(tilesX * tilesY);
+    scratch.reserve(tilesX * tilesY * 3);
+
+    setMemoryBudget(memoryBudgetBytes);
+}
+
+void GridHistory::push(const Grid& grid) {
+    // Forget the generations we rewound past
+    while (count - 1 > cursor) {
+        release(at(count - 1));
+        count--;
+    }
+
+    if (count == (int)ring.size()) {
+        if (ring.size() < maxGenerations) {
+            resizeRing(std::min(std::max<std::size_t>(ring.size() * 2, 16), maxGenerations));
+        } else {
+            dropOldest();
+        }
+    }
+
+    extractTiles(grid, nextTiles);
+
+    scratch.clear();
+    int sinceKeyframe = 0;
+    if (count > 0) {
+        for (std::size_t i = 0; i < nextTiles.size(); i++) {
+            if (nextTiles[i] != cursorTiles[i]) {
+                scratch.push_back((uint32_t)i);
+                scratch.push_back((uint32_t)nextTiles[i]);
+                scratch.push_back((uint32_t)(nextTiles[i] >> 32));
+            }
+        }
+        sinceKeyframe = at(count - 1).sinceKeyframe + 1;
+    }
+
+    // A full copy is smaller once most tiles changed, and bounds how many
+    // deltas a seek has to replay
+    Generation& generation = at(count);
+    if (count == 0 || sinceKeyframe >= KEYFRAME_INTERVAL || scratch.size() >= nextTiles.size() * 2) {
+        scratch.clear();
+        for (Tile tile : nextTiles) {
+            scratch.push_back((uint32_t)tile);
+            scratch.push_back((uint32_t)(tile >> 32));
+        }
+        sinceKeyframe = 0;
+    }
+    generation.sinceKeyframe = sinceKeyframe;
+    store(generation, scratch);
+
+    count++;
+    cursor = count - 1;
+    cursorTiles.swap(nextTiles);
+
+    enforceBudget();
+}
+
+bool GridHistory::rewind(int generations, Grid& grid) {
+    if (generations < 0 || generations > cursor) {
+        return false;
+    }
+    restore(cursor - generations, grid);
+    return true;
+}
+
+bool GridHistory::forward(int generations, Grid& grid) {
+    if (generations < 0 || cursor + generations >= count) {
+        return false;
+    }
+    restore(cursor + generations, grid);
+    return true;
+}
+
+void GridHistory::clear() {
+    while (count > 0) {
+        release(at(count - 1));
+        count--;
+    }
+    head = 0;
+    cursor = 0;
+}
+
+std::size_t GridHistory::getMemoryUsage() const {
+    return generationBytes + ring.capacity() * sizeof(Generation) +
+           heapBytes(cursorTiles.capacity() * sizeof(Tile)) +
+           heapBytes(nextTiles.capacity() * sizeof(Tile)) +
+           heapBytes(scratch.capacity() * sizeof(uint32_t));
+}
+
+void GridHistory::setMemoryBudget(std::size_t bytes) {
+    memoryBudget = bytes;
+
+    // Every generation costs at least its ring slot, which bounds how many can exist
+    maxGenerations = std::max<std::size_t>(memoryBudget / sizeof(Generation), 1);
+
+    while ((std::size_t)count > maxGenerations && cursor > 0) {
+        dropOldest();
+    }
+    if (ring.size() > maxGenerations && (std::size_t)count <= maxGenerations) {
+        resizeRing(maxGenerations);
+    }
+
+    enforceBudget();
+}
+
+GridHistory::Generation& GridHistory::at(int index) {
+    return ring[(head + index) % ring.size()];
+}
+
+void GridHistory::extractTiles(const Grid& grid, std::vector<Tile>& tiles) const {
+    for (int ty = 0; ty < tilesY; ty++) {
+        for (int tx = 0; tx < tilesX; tx++) {
+            Tile tile = 0;
+            for (int y = 0; y < TILE_HEIGHT; y++) {
+                for (int x = 0; x < TILE_WIDTH; x++) {
+                    // getCell reports cells past the edge as dead, so partial tiles pad with zeros
+                    if (grid.getCell(tx * TILE_WIDTH + x, ty * TILE_HEIGHT + y)) {
+                        tile |= (Tile)1 << (y * TILE_WIDTH + x);
+                    }
+                }
+            }
+            tiles[ty * tilesX + tx] = tile;
+        }
+    }
+}
+
+void GridHistory::restore(int index, Grid& grid) {
+    // Start from the nearest keyframe at or before the target and replay deltas
+    int keyframe = index;
+    while (at(keyframe).sinceKeyframe != 0) {
+        keyframe--;
+    }
+
+    const std::vector<uint32_t>& full = at(keyframe).data;
+    for (std::size_t i = 0; i < cursorTiles.size(); i++) {
+        cursorTiles[i] = full[i * 2] | (Tile)full[i * 2 + 1] << 32;
+    }
+    for (int i = keyframe + 1; i <= index; i++) {
+        const std::vector<uint32_t>& delta = at(i).data;
+        for (std::size_t j = 0; j < delta.size(); j += 3) {
+            cursorTiles[delta[j]] = delta[j + 1] | (Tile)delta[j + 2] << 32;
+        }
+    }
+    cursor = index;
+
+    for (int ty = 0; ty < tilesY; ty++) {
+        for (int tx = 0; tx < tilesX; tx++) {
+            Tile tile = cursorTiles[ty * tilesX + tx];
+            for (int y = 0; y < TILE_HEIGHT; y++) {
+                for (int x = 0; x < TILE_WIDTH; x++) {
+                    grid.setCell(tx * TILE_WIDTH + x, ty * TILE_HEIGHT + y,
+                                 (tile >> (y * TILE_WIDTH + x)) & 1);
+                }
+            }
+        }
+    }
+}
+
+void GridHistory::store(Generation& generation, const std::vector<uint32_t>& data) {
+    // Released slots hold no memory, so this allocates exactly data.size()
+    generation.data.assign(data.begin(), data.end());
+    generationBytes += heapBytes(generation.data.capacity() * sizeof(uint32_t));
+}
+
+void GridHistory::release(Generation& generation) {
+    generationBytes -= heapBytes(generation.data.capacity() * sizeof(uint32_t));
+    std::vector<uint32_t>().swap(generation.data);
+}
+
+void GridHistory::dropOldest() {
+    if (count == 0) {
+        return;
+    }
+
+    // The oldest generation is always a keyframe. If the next one is a delta
+    // on top of it, fold them into a keyframe for the next generation.
+    if (count > 1 && at(1).sinceKeyframe != 0) {
+        std::vector<uint32_t> full = at(0).data;
+        const std::vector<uint32_t>& delta = at(1).data;
+        for (std::size_t j = 0; j < delta.size(); j += 3) {
+            full[delta[j] * 2] = delta[j + 1];
+            full[delta[j] * 2 + 1] = delta[j + 2];
+        }
+        release(at(1));
+        at(1).sinceKeyframe = 0;
+        store(at(1), full);
+    }
+
+    release(at(0));
+    head = (head + 1) % ring.size();
+    count--;
+    if (cursor > 0) {
+        cursor--;
+    }
+}
+
+void GridHistory::resizeRing(std::size_t slots) {
+    std::vector<Generation> resized(slots);
+    for (int i = 0; i < count; i++) {
+        resized[i].data.swap(at(i).data);
+        resized[i].sinceKeyframe = at(i).sinceKeyframe;
+    }
+    ring.swap(resized);
+    head = 0;
+}
+
+void GridHistory::enforceBudget() {
+    // Never drop the current generation, so there is always something to restore
+    while (getMemoryUsage() > memoryBudget && count > 1 && cursor > 0) {
+        dropOldest();
+    }
+}
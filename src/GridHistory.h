@@ -0,0 +1,81 @@
+#ifndef GRIDHISTORY_H
+#define GRIDHISTORY_H
+
+#include "Grid.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Ring buffer of past generations used for rewinding.
+// The board is split into 16x4 tiles. Most generations store only the tiles
+// that changed since the previous one. A full copy is stored every
+// KEYFRAME_INTERVAL generations, or when most tiles changed. Memory therefore
+// grows with how much of the board changed. Seeking to any generation replays
+// at most KEYFRAME_INTERVAL deltas, however long the history is.
+class GridHistory {
+public:
+    static const int TILE_WIDTH = 16;
+    static const int TILE_HEIGHT = 4;
+    static const int KEYFRAME_INTERVAL = 32;
+
+    GridHistory(int width, int height, std::size_t memoryBudgetBytes = 4 * 1024 * 1024);
+
+    // Record the grid as the generation after the current one. Generations
+    // that were stepped back over are discarded here, not when rewinding.
+    void push(const Grid& grid);
+
+    // Move `generations` back (rewind) or forward from the current generation
+    // and restore it into `grid`. Returns false if there is nothing that far away.
+    bool rewind(int generations, Grid& grid);
+    bool forward(int generations, Grid& grid);
+
+    void clear();
+
+    // Generations stored, and how many of them are older than the current one
+    int size() const { return count; }
+    int generationsBehind() const { return cursor; }
+
+    // Heap and ring memory charged against the budget
+    std::size_t getMemoryUsage() const;
+    std::size_t getMemoryBudget() const { return memoryBudget; }
+    void setMemoryBudget(std::size_t bytes);
+
+private:
+    // Bit (y * TILE_WIDTH + x) is cell (x, y) within the tile
+    typedef uint64_t Tile;
+
+    // A keyframe stores every tile as two words (low, high). A delta stores
+    // (index, low, high) for each tile that differs from the generation before.
+    struct Generation {
+        std::vector<uint32_t> data;
+        int sinceKeyframe;      // 0 for a keyframe
+    };
+
+    int width;
+    int height;
+    int tilesX;
+    int tilesY;
+    std::size_t memoryBudget;
+    std::size_t generationBytes;    // Heap memory held by every Generation::data
+
+    std::vector<Generation> ring;   // Grows on demand up to maxGenerations
+    std::size_t maxGenerations;
+    int head;       // Ring index of the oldest generation
+    int count;
+    int cursor;     // Current generation, counted from the oldest
+
+    std::vector<Tile> cursorTiles;      // The current generation, unpacked
+    std::vector<Tile> nextTiles;        // Reused while pushing
+    std::vector<uint32_t> scratch;
+
+    Generation& at(int index);
+    void extractTiles(const Grid& grid, std::vector<Tile>& tiles) const;
+    void restore(int index, Grid& grid);
+    void store(Generation& generation, const std::vector<uint32_t>& data);
+    void release(Generation& generation);
+    void dropOldest();
+    void resizeRing(std::size_t slots);
+    void enforceBudget();
+};
+
+#endif // GRIDHISTORY_H
@@ -0,0 +1,114 @@
+#include "LookaheadPreview.h"
+
+LookaheadPreview::LookaheadPreview(int width, int height, int generations)
+    : generations(generations), requested(false), hoverX(-1), hoverY(-1),
+      lastGrid(width, height), visibleVersion(0),
+      active(false), stopping(false), job(0), base(width, height), version(0) {
+    worker = std::thread(&LookaheadPreview::workerLoop, this);
+}
+
+LookaheadPreview::~LookaheadPreview() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+void LookaheadPreview::request(const Grid& grid, int x, int y) {
+    if (requested && x == hoverX && y == hoverY && grid == lastGrid) {
+        return;
+    }
+
+    requested = true;
+    hoverX = x;
+    hoverY = y;
+    lastGrid = grid;
+
+    Grid next = grid;
+    next.setCell(x, y, true);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        // Clicking the previewed cell leaves the chain we are computing unchanged
+        if (active && next == base) {
+            return;
+        }
+
+        // If the board moved to a state we already predicted, keep the
+        // generations after it instead of starting over. A generation still
+        // being computed extends the same chain, so it stays valid.
+        bool reused = false;
+        if (active) {
+            for (std::size_t i = 0; i < frames.size(); i++) {
+                if (frames[i] == next) {
+                    frames.erase(frames.begin(), frames.begin() + i + 1);
+                    reused = true;
+                    break;
+                }
+            }
+        }
+        if (!reused) {
+            frames.clear();
+            job++;
+        }
+
+        base = next;
+        active = true;
+        version++;
+    }
+    wake.notify_one();
+}
+
+void LookaheadPreview::cancel() {
+    if (!requested) {
+        return;
+    }
+    requested = false;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        active = false;
+        frames.clear();
+        job++;
+        version++;
+    }
+}
+
+const std::vector<Grid>& LookaheadPreview::getFrames() {
+    if (version.load() != visibleVersion) {
+        std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+        if (lock.owns_lock()) {
+            visibleFrames = frames;
+            visibleVersion = version.load();
+        }
+    }
+    return visibleFrames;
+}
+
+void LookaheadPreview::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] {
+            return stopping || (active && (int)frames.size() < generations);
+        });
+        if (stopping) {
+            return;
+        }
+
+        Grid next = frames.empty() ? base : frames.back();
+        unsigned long startedJob = job;
+
+        lock.unlock();
+        next.update();
+        lock.lock();
+
+        // A new request arrived while we were simulating; this result is stale
+        if (startedJob == job) {
+            frames.push_back(next);
+            version++;
+        }
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef LOOKAHEADPREVIEW_H
+#define LOOKAHEADPREVIEW_H
+
+#include "Grid.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Speculatively simulates the next few generations of the board with the
+// hovered cell added, on a background thread. The main thread only copies
+// grids in and out, so the preview never costs simulation time in a frame.
+class LookaheadPreview {
+public:
+    static const int DEFAULT_GENERATIONS = 8;
+
+    LookaheadPreview(int width, int height, int generations = DEFAULT_GENERATIONS);
+    ~LookaheadPreview();
+
+    // Preview `grid` with the cell at (x, y) added. Cheap to call every frame:
+    // work restarts only when the grid or the hovered cell changed, and frames
+    // already computed are kept when the grid advanced as predicted.
+    void request(const Grid& grid, int x, int y);
+
+    // Stop previewing and drop all computed generations
+    void cancel();
+
+    // Generations computed so far, frames[0] being one generation ahead.
+    // Never waits for the worker; returns the last copy if it is busy.
+    const std::vector<Grid>& getFrames();
+
+    int getGenerations() const { return generations; }
+
+private:
+    int generations;
+
+    // Main thread only
+    bool requested;
+    int hoverX;
+    int hoverY;
+    Grid lastGrid;
+    std::vector<Grid> visibleFrames;
+    unsigned long visibleVersion;
+
+    // Shared with the worker, guarded by mutex
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool active;
+    bool stopping;
+    unsigned long job;          // Bumped when the chain restarts, discarding a generation in flight
+    Grid base;
+    std::vector<Grid> frames;
+    std::atomic<unsigned long> version;
+
+    std::thread worker;
+
+    void workerLoop();
+};
+
+#endif // LOOKAHEADPREVIEW_H
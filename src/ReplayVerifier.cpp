@@ -0,0 +1,223 @@
+#include "ReplayVerifier.h"
+#include "Grid.h"
+#include "GridHistory.h"
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <thread>
+
+constexpr float ReplayVerifier::TIME_TOLERANCE;
+
+namespace {
+
+// Per-thread queue of run indices. The owner takes from the back, idle
+// threads steal from the front so they rarely contend with the owner.
+struct WorkQueue {
+    std::mutex mutex;
+    std::deque<std::size_t> items;
+
+    bool popBack(std::size_t& item) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (items.empty()) {
+            return false;
+        }
+        item = items.back();
+        items.pop_back();
+        return true;
+    }
+
+    bool stealFront(std::size_t& item) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (items.empty()) {
+            return false;
+        }
+        item = items.front();
+        items.pop_front();
+        return true;
+    }
+};
+
+ReplayResult fail(const RunRecord& record, int frame, const char* reason) {
+    ReplayResult result;
+    result.passed = false;
+    result.reason = reason;
+    result.simulatedFrames = frame;
+    result.reportedTime = record.getFinalTime();
+    result.verifySeconds = 0.0;
+    return result;
+}
+
+ReplayResult verifyFile(const std::string& filename) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    RunRecord record;
+    ReplayResult result;
+    std::string error;
+    try {
+        if (RunRecord::loadFromFile(filename.c_str(), record, &error)) {
+            result = ReplayVerifier::verify(record);
+        } else {
+            result = fail(record, 0, error.c_str());
+        }
+    } catch (const std::bad_alloc&) {
+        // An exception escaping a worker thread would terminate the whole batch
+        result = fail(record, 0, "out of memory");
+    }
+    result.filename = filename;
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    result.verifySeconds = elapsed.count();
+    return result;
+}
+
+} // namespace
+
+ReplayVerifier::ReplayVerifier(int threadCount) : threadCount(threadCount) {
+    if (this->threadCount <= 0) {
+        this->threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+ReplayResult ReplayVerifier::verify(const RunRecord& record) {
+    const std::vector<RunInput>& inputs = record.getInputs();
+    const char* invalid = record.validate();
+    if (invalid) {
+        return fail(record, 0, invalid);
+    }
+
+    // The fastest the game could have reached the reported frame count
+    float minimumTime = (float)record.getFrames() / RunRecord::TARGET_FPS;
+    if (record.getFinalTime() < minimumTime * (1.0f - TIME_TOLERANCE)) {
+        return fail(record, 0, "reported time faster than frame count allows");
+    }
+
+    // Both engines produce the same boards, so use the faster one
+    Grid grid(record.getWidth(), record.getHeight());
+    grid.setEngine(ENGINE_LOOKUP);
+    GridHistory history(record.getWidth(), record.getHeight());
+    grid.randomSeed(record.getSeed(), record.getDensity());
+    history.push(grid);
+
+    // Mirror Game::handleInput followed by Game::update for every frame
+    std::size_t nextInput = 0;
+    int frameCounter = 0;
+    bool changed = true;
+    for (int frame = 0; frame < record.getFrames(); frame++) {
+        for (; nextInput < inputs.size() && inputs[nextInput].frame <= frame; nextInput++) {
+            const RunInput& input = inputs[nextInput];
+            if (input.frame < frame) {
+                return fail(record, frame, "inputs out of order");
+            }
+
+            if (input.type == RunInput::SET_CELL) {
+                grid.setCell(input.x, input.y, true);
+            } else {
+                if (!history.rewind(input.x, grid)) {
+                    return fail(record, frame, "rewind past recorded history");
+                }
+                frameCounter = 0;
+                changed = true;
+            }
+        }
+
+        frameCounter++;
+        if (frameCounter >= RunRecord::FRAMES_PER_GENERATION) {
+            grid.update();
+            history.push(grid);
+            frameCounter = 0;
+            changed = true;
+        }
+
+        // Placing cells cannot empty the board, so only recount after it changed
+        if (changed) {
+            changed = false;
+            if (grid.countAliveCells() == 0) {
+                if (frame + 1 != record.getFrames() || nextInput != inputs.size()) {
+                    return fail(record, frame + 1, "board cleared before the reported frame");
+                }
+
+                ReplayResult result;
+                result.passed = true;
+                result.simulatedFrames = frame + 1;
+                result.reportedTime = record.getFinalTime();
+                result.verifySeconds = 0.0;
+                return result;
+            }
+        }
+    }
+
+    return fail(record, record.getFrames(), "board not cleared by the reported frame");
+}
+
+bool ReplayVerifier::verifyDirectory(const char* directory, std::vector<ReplayResult>& results) const {
+    std::vector<std::string> filenames;
+
+    DIR* dir = opendir(directory);
+    if (!dir) {
+        return false;
+    }
+
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+            continue;
+        }
+
+        std::string fullPath = std::string(directory) + "/" + std::string(entry->d_name);
+
+        struct stat statbuf;
+        if (stat(fullPath.c_str(), &statbuf) == 0 && S_ISREG(statbuf.st_mode)) {
+            filenames.push_back(fullPath);
+        }
+    }
+
+    closedir(dir);
+
+    // Stable output order regardless of directory listing order
+    std::sort(filenames.begin(), filenames.end());
+    results = verifyFiles(filenames);
+    return true;
+}
+
+std::vector<ReplayResult> ReplayVerifier::verifyFiles(const std::vector<std::string>& filenames) const {
+    std::vector<ReplayResult> results(filenames.size());
+    int workers = std::min<int>(threadCount, std::max<std::size_t>(1, filenames.size()));
+
+    // Deal runs out round-robin, stealing evens out runs of very different lengths
+    std::vector<WorkQueue> queues(workers);
+    for (std::size_t i = 0; i < filenames.size(); i++) {
+        queues[i % workers].items.push_back(i);
+    }
+
+    // No new work appears once verification starts, so a worker may stop as
+    // soon as its own queue and every other queue are empty
+    auto work = [&](int self) {
+        std::size_t item;
+        while (true) {
+            bool found = queues[self].popBack(item);
+            for (int i = 1; !found && i < workers; i++) {
+                found = queues[(self + i) % workers].stealFront(item);
+            }
+            if (!found) {
+                return;
+            }
+            results[item] = verifyFile(filenames[item]);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < workers; i++) {
+        threads.push_back(std::thread(work, i));
+    }
+    work(0);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    return results;
+}
@@ -0,0 +1,40 @@
+#ifndef REPLAYVERIFIER_H
+#define REPLAYVERIFIER_H
+
+#include "RunRecord.h"
+#include <string>
+#include <vector>
+
+struct ReplayResult {
+    std::string filename;
+    bool passed;
+    std::string reason;        // Why the run failed, empty when it passed
+    int simulatedFrames;       // Frame on which the board cleared, or frames simulated before giving up
+    float reportedTime;
+    double verifySeconds;      // Wall time spent verifying this run
+};
+
+// Re-simulates recorded runs headlessly and checks that the reported clear
+// time is legitimate. Runs are spread across threads with work stealing.
+class ReplayVerifier {
+public:
+    // Reported times may be at most this much faster than TARGET_FPS allows
+    static constexpr float TIME_TOLERANCE = 0.02f;
+
+    explicit ReplayVerifier(int threadCount = 0);
+
+    // Verify a single run
+    static ReplayResult verify(const RunRecord& record);
+
+    // Load and verify every run file in a directory. Returns false, with errno
+    // set, if the directory cannot be read.
+    bool verifyDirectory(const char* directory, std::vector<ReplayResult>& results) const;
+
+    // Load and verify the given run files, results are in the same order
+    std::vector<ReplayResult> verifyFiles(const std::vector<std::string>& filenames) const;
+
+private:
+    int threadCount;
+};
+
+#endif // REPLAYVERIFIER_H
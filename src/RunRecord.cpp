@@ -0,0 +1,147 @@
+#include "RunRecord.h"
+#include <fstream>
+#include <sstream>
+
+static const char* RUN_FILE_HEADER = "BitBloom run";
+
+constexpr float RunRecord::SEED_DENSITY;
+
+// A frame has at most one cell placement and one rewind
+static const std::size_t MAX_INPUTS = 2 * (std::size_t)RunRecord::MAX_FRAMES;
+
+RunRecord::RunRecord()
+    : width(0), height(0), seed(0), density(0.0f), frames(0), finalTime(0.0f) {
+}
+
+void RunRecord::begin(int w, int h, unsigned int s, float d) {
+    width = w;
+    height = h;
+    seed = s;
+    density = d;
+    frames = 0;
+    finalTime = 0.0f;
+    inputs.clear();
+}
+
+void RunRecord::addSetCell(int frame, int x, int y) {
+    RunInput input = { RunInput::SET_CELL, frame, x, y };
+    inputs.push_back(input);
+}
+
+void RunRecord::addRewind(int frame, int generationsBack) {
+    RunInput input = { RunInput::REWIND, frame, generationsBack, 0 };
+    inputs.push_back(input);
+}
+
+void RunRecord::finish(int totalFrames, float time) {
+    frames = totalFrames;
+    finalTime = time;
+}
+
+const char* RunRecord::validate() const {
+    if (width != GRID_WIDTH || height != GRID_HEIGHT) {
+        return "board size does not match the game";
+    }
+    if (density != SEED_DENSITY) {
+        return "seed density does not match the game";
+    }
+    if (frames <= 0 || frames > MAX_FRAMES) {
+        return "frame count out of range";
+    }
+    if (inputs.size() > MAX_INPUTS) {
+        return "too many inputs";
+    }
+    return nullptr;
+}
+
+bool RunRecord::saveToFile(const char* filename) const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    file << RUN_FILE_HEADER << "\n";
+    file << "size " << width << " " << height << "\n";
+    file << "seed " << seed << "\n";
+    file << "density " << density << "\n";
+    file << "frames " << frames << "\n";
+    file.precision(9);
+    file << "time " << finalTime << "\n";
+
+    for (const RunInput& input : inputs) {
+        if (input.type == RunInput::SET_CELL) {
+            file << "cell " << input.frame << " " << input.x << " " << input.y << "\n";
+        } else {
+            file << "rewind " << input.frame << " " << input.x << "\n";
+        }
+    }
+
+    return file.good();
+}
+
+bool RunRecord::loadFromFile(const char* filename, RunRecord& record, std::string* error) {
+    std::string ignored;
+    std::string& reason = error ? *error : ignored;
+
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        reason = "cannot open run file";
+        return false;
+    }
+
+    std::string line;
+    std::getline(file, line);
+    if (line.compare(0, line.find_last_not_of(" \t\r\n") + 1, RUN_FILE_HEADER) != 0) {
+        reason = "not a run file";
+        return false;
+    }
+
+    record = RunRecord();
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        std::string key;
+        if (!(fields >> key)) {
+            continue;  // Skip empty lines
+        }
+
+        bool ok;
+        if (key == "size") {
+            ok = (bool)(fields >> record.width >> record.height);
+        } else if (key == "seed") {
+            ok = (bool)(fields >> record.seed);
+        } else if (key == "density") {
+            ok = (bool)(fields >> record.density);
+        } else if (key == "frames") {
+            ok = (bool)(fields >> record.frames);
+        } else if (key == "time") {
+            ok = (bool)(fields >> record.finalTime);
+        } else if (key == "cell") {
+            RunInput input = { RunInput::SET_CELL, 0, 0, 0 };
+            ok = (bool)(fields >> input.frame >> input.x >> input.y);
+            record.inputs.push_back(input);
+        } else if (key == "rewind") {
+            RunInput input = { RunInput::REWIND, 0, 0, 0 };
+            ok = (bool)(fields >> input.frame >> input.x);
+            record.inputs.push_back(input);
+        } else {
+            ok = false;
+        }
+
+        if (!ok) {
+            reason = "malformed line: " + line;
+            return false;
+        }
+        // Stop reading before an oversized file can use up memory
+        if (record.inputs.size() > MAX_INPUTS) {
+            reason = "too many inputs";
+            return false;
+        }
+    }
+
+    const char* invalid = record.validate();
+    if (invalid) {
+        reason = invalid;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,65 @@
+#ifndef RUNRECORD_H
+#define RUNRECORD_H
+
+#include <string>
+#include <vector>
+
+// Everything needed to re-simulate a finished game: the starting seed and
+// every input together with the frame it happened on.
+struct RunInput {
+    enum Type {
+        SET_CELL,
+        REWIND
+    };
+
+    Type type;
+    int frame;
+    int x;      // SET_CELL: cell position. REWIND: generations rewound
+    int y;
+};
+
+class RunRecord {
+public:
+    // Game configuration shared by Game and the replay verifier. Run files
+    // must match it, so a run cannot pick an easier board.
+    static const int TARGET_FPS = 60;
+    static const int FRAMES_PER_GENERATION = 6;
+    static const int GRID_WIDTH = 80;
+    static const int GRID_HEIGHT = 60;
+    static constexpr float SEED_DENSITY = 0.3f;
+    static const int MAX_FRAMES = TARGET_FPS * 60 * 60;    // One hour
+
+    RunRecord();
+
+    void begin(int width, int height, unsigned int seed, float density);
+    void addSetCell(int frame, int x, int y);
+    void addRewind(int frame, int generationsBack);
+    void finish(int frames, float finalTime);
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    unsigned int getSeed() const { return seed; }
+    float getDensity() const { return density; }
+    int getFrames() const { return frames; }
+    float getFinalTime() const { return finalTime; }
+    const std::vector<RunInput>& getInputs() const { return inputs; }
+
+    // Reason this record does not describe a possible game, or nullptr if it does
+    const char* validate() const;
+
+    // Save to / load from a plain text run file. Loading rejects invalid
+    // records and, if given, sets `error` to the reason.
+    bool saveToFile(const char* filename) const;
+    static bool loadFromFile(const char* filename, RunRecord& record, std::string* error = nullptr);
+
+private:
+    int width;
+    int height;
+    unsigned int seed;
+    float density;
+    int frames;
+    float finalTime;
+    std::vector<RunInput> inputs;
+};
+
+#endif // RUNRECORD_H
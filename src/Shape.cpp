@@ -3,7 +3,7 @@
 #include <sstream>
 
 Shape::Shape(const std::string& name, const std::vector<std::vector<bool>>& pattern)
-    : name(name), pattern(pattern), callback(nullptr) {
+    : name(name), pattern(pattern) {
     height = pattern.size();
     width = (height > 0) ? pattern[0].size() : 0;
 }
@@ -15,16 +15,6 @@ bool Shape::getCell(int x, int y) const {
     return pattern[y][x];
 }
 
-void Shape::setCallback(std::function<void(int, int)> cb) {
-    callback = cb;
-}
-
-void Shape::triggerCallback(int x, int y) const {
-    if (callback) {
-        callback(x, y);
-    }
-}
-
 Shape* Shape::loadFromFile(const char* filename) {
     std::ifstream file(filename);
     if (!file.is_open()) {
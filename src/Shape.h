@@ -3,7 +3,6 @@
 
 #include <string>
 #include <vector>
-#include <functional>
 
 class Shape {
 public:
@@ -14,10 +13,6 @@ public:
     int getHeight() const { return height; }
     bool getCell(int x, int y) const;
     
-    // Set a callback function to be called when this shape is detected
-    void setCallback(std::function<void(int, int)> callback);
-    void triggerCallback(int x, int y) const;
-    
     // Load shape from file
     static Shape* loadFromFile(const char* filename);
     
@@ -26,7 +21,6 @@ private:
     int width;
     int height;
     std::vector<std::vector<bool>> pattern;
-    std::function<void(int, int)> callback;  // Called with center position when detected
 };
 
 #endif // SHAPE_H
@@ -3,7 +3,7 @@
 #include <sys/stat.h>
 #include <cstring>
 
-ShapeDetector::ShapeDetector() {
+ShapeDetector::ShapeDetector() : eventCount(0), sizedWidth(0), sizedHeight(0), sizedShapeCount(0) {
 }
 
 ShapeDetector::~ShapeDetector() {
@@ -49,6 +49,28 @@ void ShapeDetector::addShape(Shape* shape) {
     }
 }
 
+int ShapeDetector::findShapeId(const std::string& name) const {
+    for (std::size_t i = 0; i < shapes.size(); i++) {
+        if (shapes[i]->getName() == name) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+void ShapeDetector::subscribe(int shapeId, ShapeBatchHandler handler) {
+    if (shapeId < 0 || shapeId >= (int)shapes.size()) {
+        return;
+    }
+    Subscription subscription = { shapeId, handler };
+    subscriptions.push_back(subscription);
+}
+
+void ShapeDetector::subscribeAll(ShapeBatchHandler handler) {
+    Subscription subscription = { -1, handler };
+    subscriptions.push_back(subscription);
+}
+
 bool ShapeDetector::matchesShapeAt(const Grid& grid, const Shape& shape, int x, int y) const {
     // Check if the shape matches at position (x, y)
     // (x, y) is the top-left corner of where we're checking
@@ -71,18 +93,76 @@ bool ShapeDetector::matchesShapeAt(const Grid& grid, const Shape& shape, int x,
     return true;
 }
 
-void ShapeDetector::detectAndTrigger(const Grid& grid) {
+bool ShapeDetector::detect(const Grid& grid) {
+    eventCount = 0;
+    shapeEventStart.assign(shapes.size() + 1, 0);
+    
+    // Centers are stored as 16-bit coordinates and IDs as 16-bit indices
+    if (grid.getWidth() > MAX_COORDINATE + 1 || grid.getHeight() > MAX_COORDINATE + 1 ||
+        shapes.size() > MAX_SHAPES) {
+        return false;
+    }
+    
+    // Every position of every shape could match at once; size for that when
+    // the grid or shape set changes so the scan below never allocates
+    if (grid.getWidth() != sizedWidth || grid.getHeight() != sizedHeight || shapes.size() != sizedShapeCount) {
+        std::size_t maxEvents = 0;
+        for (Shape* shape : shapes) {
+            int positionsX = grid.getWidth() - shape->getWidth() + 1;
+            int positionsY = grid.getHeight() - shape->getHeight() + 1;
+            if (positionsX > 0 && positionsY > 0) {
+                maxEvents += (std::size_t)positionsX * positionsY;
+            }
+        }
+        events.resize(maxEvents);
+        sizedWidth = grid.getWidth();
+        sizedHeight = grid.getHeight();
+        sizedShapeCount = shapes.size();
+    }
+    
     // Check every position in the grid for every shape
-    for (Shape* shape : shapes) {
-        for (int y = 0; y <= grid.getHeight() - shape->getHeight(); y++) {
-            for (int x = 0; x <= grid.getWidth() - shape->getWidth(); x++) {
-                if (matchesShapeAt(grid, *shape, x, y)) {
-                    // Found a match! Trigger callback with center position
-                    int centerX = x + shape->getWidth() / 2;
-                    int centerY = y + shape->getHeight() / 2;
-                    shape->triggerCallback(centerX, centerY);
+    for (std::size_t id = 0; id < shapes.size(); id++) {
+        const Shape& shape = *shapes[id];
+        shapeEventStart[id] = eventCount;
+        
+        for (int y = 0; y <= grid.getHeight() - shape.getHeight(); y++) {
+            for (int x = 0; x <= grid.getWidth() - shape.getWidth(); x++) {
+                if (matchesShapeAt(grid, shape, x, y)) {
+                    // Found a match! Record it with the center position
+                    ShapeEvent& event = events[eventCount++];
+                    event.shapeId = (uint16_t)id;
+                    event.x = (uint16_t)(x + shape.getWidth() / 2);
+                    event.y = (uint16_t)(y + shape.getHeight() / 2);
+                    event.orientation = 0;
                 }
             }
         }
     }
+    shapeEventStart[shapes.size()] = eventCount;
+    return true;
+}
+
+void ShapeDetector::dispatch() const {
+    if (eventCount == 0) {
+        return;
+    }
+    
+    for (const Subscription& subscription : subscriptions) {
+        if (subscription.shapeId < 0) {
+            subscription.handler(events.data(), eventCount);
+            continue;
+        }
+        
+        std::size_t start = shapeEventStart[subscription.shapeId];
+        std::size_t count = shapeEventStart[subscription.shapeId + 1] - start;
+        if (count > 0) {
+            subscription.handler(events.data() + start, count);
+        }
+    }
+}
+
+void ShapeDetector::detectAndDispatch(const Grid& grid) {
+    if (detect(grid)) {
+        dispatch();
+    }
 }
@@ -3,11 +3,29 @@
 
 #include "Shape.h"
 #include "Grid.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <vector>
 #include <string>
 
+// One detected shape, written by detect() into a reusable buffer
+struct ShapeEvent {
+    uint16_t shapeId;       // Index into getShapes()
+    uint16_t x;             // Center position of the match
+    uint16_t y;
+    uint8_t orientation;    // Patterns are matched as loaded, so always 0
+};
+
+// Receives every event for a shape from one detection pass at once
+typedef std::function<void(const ShapeEvent* events, std::size_t count)> ShapeBatchHandler;
+
 class ShapeDetector {
 public:
+    // Largest grid side and shape count a ShapeEvent can describe
+    static const int MAX_COORDINATE = UINT16_MAX;
+    static const std::size_t MAX_SHAPES = (std::size_t)UINT16_MAX + 1;
+    
     ShapeDetector();
     ~ShapeDetector();
     
@@ -17,17 +35,51 @@ public:
     // Add a single shape
     void addShape(Shape* shape);
     
+    // Integer ID of a loaded shape, or -1 if no shape has that name.
+    // Look IDs up once and subscribe with them; detection never compares names.
+    int findShapeId(const std::string& name) const;
+    
+    // Receive the batch of events for one shape, or for all shapes, after each pass
+    void subscribe(int shapeId, ShapeBatchHandler handler);
+    void subscribeAll(ShapeBatchHandler handler);
+    
     // Check if a specific shape matches at position (x, y) on the grid
     bool matchesShapeAt(const Grid& grid, const Shape& shape, int x, int y) const;
     
-    // Detect all shapes in the grid and trigger their callbacks
-    void detectAndTrigger(const Grid& grid);
+    // Scan the grid for every shape and record matches in the event buffer.
+    // The buffer holds every possible match and is only resized when the grid
+    // size or shape set changes, never per match. Returns false without
+    // scanning if the grid is wider or taller than MAX_COORDINATE + 1, or more
+    // than MAX_SHAPES shapes are loaded.
+    bool detect(const Grid& grid);
+    
+    // Hand the last pass's events to subscribers, one call per non-empty batch
+    void dispatch() const;
+    
+    void detectAndDispatch(const Grid& grid);
+    
+    // Events from the last detect(), grouped by shape ID
+    const ShapeEvent* getEvents() const { return events.data(); }
+    std::size_t getEventCount() const { return eventCount; }
     
     // Get all loaded shapes
     const std::vector<Shape*>& getShapes() const { return shapes; }
     
 private:
+    struct Subscription {
+        int shapeId;    // -1 for every shape
+        ShapeBatchHandler handler;
+    };
+    
     std::vector<Shape*> shapes;
+    std::vector<Subscription> subscriptions;
+    
+    std::vector<ShapeEvent> events;
+    std::size_t eventCount;
+    int sizedWidth;                 // Grid size and shape count the buffer was sized for
+    int sizedHeight;
+    std::size_t sizedShapeCount;
+    std::vector<std::size_t> shapeEventStart;   // Events of shape i are [start[i], start[i + 1])
 };
 
 #endif // SHAPEDETECTOR_H
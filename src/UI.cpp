@@ -82,7 +82,7 @@ void UI::drawGameUI(int aliveCells, float gameTimer, int screenWidth, int screen
     
     // Draw bottom UI bar
     DrawRectangle(0, screenHeight - UI_BOTTOM_HEIGHT, screenWidth, UI_BOTTOM_HEIGHT, BLACK);
-    DrawText("Left Click: Place Cell | ESC: Menu", 10, screenHeight - 30, 18, GRAY);
+    DrawText("Left Click: Place Cell | Z: Rewind | ESC: Menu", 10, screenHeight - 30, 18, GRAY);
 }
 
 void UI::drawWinScreen(float finalTime, int screenWidth, int screenHeight) {
@@ -0,0 +1,53 @@
+#include "Grid.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+// Times every Grid engine on a few board sizes and checks they agree
+static double timeEngine(Grid& grid, GridEngine engine, int generations) {
+    grid.setEngine(engine);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i = 0; i < generations; i++) {
+        grid.update();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+int main(int argc, char** argv) {
+    int generations = (argc >= 2) ? atoi(argv[1]) : 100;
+
+    const int sizes[][2] = { { 80, 60 }, { 81, 61 }, { 256, 256 }, { 512, 512 } };
+    const struct {
+        GridEngine engine;
+        const char* name;
+    } engines[] = {
+        { ENGINE_CELLWISE, "cellwise" },
+        { ENGINE_LOOKUP, "lookup" }
+    };
+
+    bool allMatch = true;
+    for (const auto& size : sizes) {
+        Grid seeded(size[0], size[1]);
+        seeded.randomSeed(1, 0.3f);
+
+        Grid reference(0, 0);
+        for (const auto& entry : engines) {
+            Grid grid = seeded;
+            double seconds = timeEngine(grid, entry.engine, generations);
+            double cells = (double)size[0] * size[1] * generations;
+            printf("%-9s %5dx%-5d %6d gen  %8.3fs  %8.1f gen/s  %8.2f Mcells/s\n",
+                   entry.name, size[0], size[1], generations, seconds,
+                   generations / seconds, cells / seconds / 1e6);
+
+            if (entry.engine == ENGINE_CELLWISE) {
+                reference = grid;
+            } else if (grid != reference) {
+                printf("MISMATCH: %s differs from cellwise\n", entry.name);
+                allMatch = false;
+            }
+        }
+    }
+
+    return allMatch ? 0 : 1;
+}
@@ -0,0 +1,86 @@
+#include "DistributedGrid.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// Runs a large board across local worker processes. With --check the same
+// board is also stepped with Grid::update and the results are compared.
+int main(int argc, char** argv) {
+    int width = 2048;
+    int height = 2048;
+    int workers = 4;
+    int generations = 200;
+    unsigned int seed = 1;
+    bool check = false;
+
+    int positional = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--check") == 0) {
+            check = true;
+            continue;
+        }
+        switch (positional++) {
+            case 0: width = atoi(argv[i]); break;
+            case 1: height = atoi(argv[i]); break;
+            case 2: workers = atoi(argv[i]); break;
+            case 3: generations = atoi(argv[i]); break;
+            case 4: seed = (unsigned int)strtoul(argv[i], nullptr, 10); break;
+            default:
+                printf("Usage: %s [width height workers generations seed] [--check]\n", argv[0]);
+                return 2;
+        }
+    }
+
+    Grid grid(width, height);
+    grid.randomSeed(seed, 0.3f);
+
+    DistributedGrid distributed(width, height, workers);
+    if (!distributed.start(grid)) {
+        return 1;
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    bool ok = distributed.runUntilExtinct(generations);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    if (!ok) {
+        return 1;
+    }
+
+    printf("%dx%d board, %d workers: %d generations in %.3fs (%.1f gen/s), %d alive\n",
+           width, height, distributed.getWorkerCount(), distributed.getGeneration(), elapsed.count(),
+           distributed.getGeneration() / elapsed.count(), distributed.countAliveCells());
+    if (distributed.getExtinctGeneration() >= 0) {
+        printf("Died out at generation %d\n", distributed.getExtinctGeneration());
+    }
+
+    if (check) {
+        for (int i = 0; i < distributed.getGeneration(); i++) {
+            grid.update();
+        }
+
+        Grid gathered(width, height);
+        distributed.copyTo(gathered);
+        if (gathered != grid || distributed.countAliveCells() != grid.countAliveCells()) {
+            printf("MISMATCH against Grid::update\n");
+            return 1;
+        }
+        // The extinction generation must be the first empty one
+        if (distributed.getExtinctGeneration() > 0) {
+            Grid before(width, height);
+            before.randomSeed(seed, 0.3f);
+            for (int i = 0; i < distributed.getExtinctGeneration() - 1; i++) {
+                before.update();
+            }
+            Grid after = before;
+            after.update();
+            if (before.countAliveCells() == 0 || after.countAliveCells() != 0) {
+                printf("MISMATCH in extinction generation\n");
+                return 1;
+            }
+        }
+        printf("Matches Grid::update\n");
+    }
+
+    return 0;
+}
@@ -0,0 +1,45 @@
+#include "ReplayVerifier.h"
+#include <chrono>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        printf("Usage: %s <runs-directory> [threads]\n", argv[0]);
+        return 2;
+    }
+
+    int threads = (argc >= 3) ? atoi(argv[2]) : 0;
+    ReplayVerifier verifier(threads);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::vector<ReplayResult> results;
+    if (!verifier.verifyDirectory(argv[1], results)) {
+        fprintf(stderr, "Cannot read runs directory %s: %s\n", argv[1], strerror(errno));
+        return 2;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    int passed = 0;
+    for (const ReplayResult& result : results) {
+        if (result.passed) {
+            passed++;
+            printf("PASS %s frames=%d time=%.2fs verify=%.2fms\n",
+                   result.filename.c_str(), result.simulatedFrames, result.reportedTime,
+                   result.verifySeconds * 1000.0);
+        } else {
+            printf("FAIL %s frames=%d time=%.2fs verify=%.2fms (%s)\n",
+                   result.filename.c_str(), result.simulatedFrames, result.reportedTime,
+                   result.verifySeconds * 1000.0, result.reason.c_str());
+        }
+    }
+
+    double seconds = elapsed.count();
+    printf("\n%d/%d runs passed in %.2fs (%.0f runs/min)\n",
+           passed, (int)results.size(), seconds,
+           seconds > 0.0 ? results.size() * 60.0 / seconds : 0.0);
+
+    return (passed == (int)results.size()) ? 0 : 1;
+}